@@ -0,0 +1,70 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/// Blocking FIFO with fixed capacity between a producer and a pool of consumers.
+///
+/// push() waits while the queue is full, pop() waits while it is empty. After
+/// close() no further items are accepted, and pop() returns false once the
+/// remaining items are drained. Items are moved in and out, so ownership
+/// (i.e. std::unique_ptr) passes from the producer to exactly one consumer.
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(size_t capacity) : mCapacity(capacity > 0 ? capacity : 1) {}
+  ~BoundedQueue() = default;
+
+  /// Add an item, false if the queue was closed (the item is not consumed then)
+  bool push(T &&item)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mNotFull.wait(lock, [this]
+                  { return mClosed || mItems.size() < mCapacity; });
+    if (mClosed)
+      return false;
+    mItems.push_back(std::move(item));
+    lock.unlock();
+    mNotEmpty.notify_one();
+    return true;
+  }
+
+  /// Take the oldest item, false if the queue is closed and empty
+  bool pop(T &item)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mNotEmpty.wait(lock, [this]
+                   { return mClosed || !mItems.empty(); });
+    if (mItems.empty())
+      return false;
+    item = std::move(mItems.front());
+    mItems.pop_front();
+    lock.unlock();
+    mNotFull.notify_one();
+    return true;
+  }
+
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mClosed = true;
+    }
+    mNotEmpty.notify_all();
+    mNotFull.notify_all();
+  }
+
+private:
+  size_t mCapacity;
+  bool mClosed = false;
+  std::deque<T> mItems;
+  std::mutex mMutex;
+  std::condition_variable mNotEmpty;
+  std::condition_variable mNotFull;
+};
+
+#endif
@@ -0,0 +1,380 @@
+#ifndef EVENTCACHE_H
+#define EVENTCACHE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ParticleBuffer.h"
+#include "PartonAncestry.h"
+
+/// Binary cache of the analysis input of an event, for re-analysis without
+/// regeneration or HepMC parsing.
+///
+/// File layout (native byte order, all blocks 8-byte aligned):
+/// - file header: magic "JETEVC01", format version, number of events
+/// - per event: EventCacheHeader, nparticles x CachedParticle, npartons x CachedParton
+///
+/// The number of events is set when the writer is closed after all writes
+/// succeeded. It stays 0 in files of failed or crashed jobs, and the reader
+/// refuses such files as well as files whose records do not match the count.
+///
+/// Only final-state particles within |eta| < 0.7 are stored. The origin of a
+/// particle is the index of its parton in the parton table of the same event
+/// (or -1), so the flavour of a jet can be assigned without the event record.
+struct EventCacheHeader
+{
+  double weight;       ///< event weight as used by the analysis (cross section in mb)
+  double pthard;       ///< hard scale used for the event kt and the outlier cut
+  double scale;        ///< event scale from the generator
+  double crosssection; ///< generator cross section
+  int64_t trials;      ///< number of trials (1 if not provided by the generator)
+  int32_t pthardbin;   ///< pt-hard bin, -1 for unbinned productions
+  uint32_t nparticles;
+  uint32_t npartons;
+  uint32_t reserved;
+};
+
+struct CachedParticle
+{
+  double px;
+  double py;
+  double pz;
+  double e;
+  int32_t pdg;
+  int32_t origin; ///< index in the parton table of the event, -1 if no parton was found
+};
+
+struct CachedParton
+{
+  int32_t pdg;
+  int32_t reserved;
+  double e;
+};
+
+static_assert(sizeof(EventCacheHeader) % 8 == 0 && sizeof(CachedParticle) % 8 == 0 && sizeof(CachedParton) % 8 == 0, "Event cache blocks must keep 8-byte alignment");
+
+namespace EventCacheFormat
+{
+  const char kMagic[8] = {'J', 'E', 'T', 'E', 'V', 'C', '0', '1'};
+  const uint32_t kVersion = 2;
+  const size_t kEventCountOffset = 12;
+  const size_t kFileHeaderSize = 16;
+}
+
+/// Cache content of one event, reused between events by the writing worker
+class EventCacheRecord
+{
+public:
+  EventCacheRecord() = default;
+  ~EventCacheRecord() = default;
+
+  /// Fill the record from the selected particles and the ancestry table of the event.
+  /// partonOf(index) returns pdg code and energy of the particle at the index in the event record.
+  template <typename PartonFunc>
+  void fill(const ParticleBuffer &particles, const PartonAncestry &ancestry, PartonFunc &&partonOf)
+  {
+    mParticles.clear();
+    mPartons.clear();
+    mPartonSlot.assign(ancestry.size(), -1);
+    for (int ipart = 0; ipart < particles.size(); ipart++)
+    {
+      int origin = ancestry.getOrigin(particles.getIndex(ipart)), slot = -1;
+      if (origin >= 0)
+      {
+        if (mPartonSlot[origin] < 0)
+        {
+          auto parton = partonOf(origin);
+          mPartonSlot[origin] = mPartons.size();
+          mPartons.push_back({parton.first, 0, parton.second});
+        }
+        slot = mPartonSlot[origin];
+      }
+      mParticles.push_back({particles.getPx(ipart), particles.getPy(ipart), particles.getPz(ipart), particles.getE(ipart), particles.getPdg(ipart), slot});
+    }
+    mHeader.nparticles = mParticles.size();
+    mHeader.npartons = mPartons.size();
+  }
+
+  void setEventInfo(double weight, double pthard, double scale, double crosssection, int64_t trials, int pthardbin = -1)
+  {
+    mHeader.weight = weight;
+    mHeader.pthard = pthard;
+    mHeader.scale = scale;
+    mHeader.crosssection = crosssection;
+    mHeader.trials = trials;
+    mHeader.pthardbin = pthardbin;
+    mHeader.reserved = 0;
+  }
+
+  const EventCacheHeader &getHeader() const { return mHeader; }
+  const std::vector<CachedParticle> &getParticles() const { return mParticles; }
+  const std::vector<CachedParton> &getPartons() const { return mPartons; }
+
+private:
+  EventCacheHeader mHeader = {};
+  std::vector<CachedParticle> mParticles;
+  std::vector<CachedParton> mPartons;
+  std::vector<int> mPartonSlot;
+};
+
+/// Streaming writer, events are appended with buffered stdio writes.
+/// write() may be called from several workers, each event record is
+/// written as a whole under a lock. After the first failed write (e.g.
+/// disk full) nothing more is written and the file is left without event
+/// count, so it cannot be read.
+class EventCacheWriter
+{
+public:
+  EventCacheWriter() = default;
+  ~EventCacheWriter() { close(); }
+
+  bool open(const char *filename)
+  {
+    close();
+    mFile = std::fopen(filename, "wb");
+    if (!mFile)
+    {
+      std::cerr << "Cannot open event cache " << filename << " for writing" << std::endl;
+      return false;
+    }
+    const uint32_t nevents = 0;
+    mNevents = 0;
+    mFailed = false;
+    writeBlock(EventCacheFormat::kMagic, 1, sizeof(EventCacheFormat::kMagic));
+    writeBlock(&EventCacheFormat::kVersion, sizeof(uint32_t), 1);
+    writeBlock(&nevents, sizeof(uint32_t), 1);
+    if (mFailed)
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  /// Set the event count in the file header and close the file, false if any write failed
+  bool close()
+  {
+    if (!mFile)
+      return false;
+    if (!mFailed)
+    {
+      const uint32_t nevents = mNevents;
+      if (std::fflush(mFile) || std::fseek(mFile, EventCacheFormat::kEventCountOffset, SEEK_SET))
+        mFailed = true;
+      else
+        writeBlock(&nevents, sizeof(uint32_t), 1);
+    }
+    if (std::fclose(mFile))
+      mFailed = true;
+    mFile = nullptr;
+    if (mFailed)
+    {
+      std::cerr << "Writing the event cache failed after " << mNevents << " events, the cache is incomplete and cannot be read" << std::endl;
+      return false;
+    }
+    std::cout << "Wrote " << mNevents << " events to event cache" << std::endl;
+    return true;
+  }
+
+  bool isOpen() const { return mFile != nullptr; }
+
+  void write(const EventCacheRecord &record)
+  {
+    if (!mFile)
+      return;
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFailed)
+      return;
+    const auto &particles = record.getParticles();
+    const auto &partons = record.getPartons();
+    writeBlock(&record.getHeader(), sizeof(EventCacheHeader), 1);
+    writeBlock(particles.data(), sizeof(CachedParticle), particles.size());
+    writeBlock(partons.data(), sizeof(CachedParton), partons.size());
+    if (!mFailed)
+      mNevents++;
+  }
+
+private:
+  void writeBlock(const void *data, size_t size, size_t count)
+  {
+    if (mFailed || !count)
+      return;
+    if (std::fwrite(data, size, count, mFile) != count)
+    {
+      std::cerr << "Error writing event cache: " << std::strerror(errno) << std::endl;
+      mFailed = true;
+    }
+  }
+
+  FILE *mFile = nullptr;
+  std::mutex mMutex;
+  uint32_t mNevents = 0;
+  bool mFailed = false;
+};
+
+/// View on one event in a memory-mapped cache file, valid as long as the reader is open
+class EventCacheEvent
+{
+public:
+  EventCacheEvent() = default;
+  EventCacheEvent(const EventCacheHeader *header, const CachedParticle *particles, const CachedParton *partons) : mHeader(header), mParticles(particles), mPartons(partons) {}
+  ~EventCacheEvent() = default;
+
+  const EventCacheHeader &getHeader() const { return *mHeader; }
+  int getNParticles() const { return mHeader->nparticles; }
+  int getNPartons() const { return mHeader->npartons; }
+  const CachedParticle &getParticle(int ipart) const { return mParticles[ipart]; }
+  const CachedParton &getParton(int iparton) const { return mPartons[iparton]; }
+
+private:
+  const EventCacheHeader *mHeader = nullptr;
+  const CachedParticle *mParticles = nullptr;
+  const CachedParton *mPartons = nullptr;
+};
+
+/// Reader on a memory-mapped cache file. The particle and parton blocks of the
+/// events are accessed in place, without copy. next() may be called from several
+/// workers, each event is handed out once.
+class EventCacheReader
+{
+public:
+  EventCacheReader() = default;
+  ~EventCacheReader() { close(); }
+
+  /// Whether the file starts with the magic of the event cache
+  static bool isEventCache(const char *filename)
+  {
+    char magic[sizeof(EventCacheFormat::kMagic)];
+    FILE *reader = std::fopen(filename, "rb");
+    if (!reader)
+      return false;
+    bool found = std::fread(magic, 1, sizeof(magic), reader) == sizeof(magic) && !std::memcmp(magic, EventCacheFormat::kMagic, sizeof(magic));
+    std::fclose(reader);
+    return found;
+  }
+
+  bool open(const char *filename)
+  {
+    close();
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+      std::cerr << "Cannot open event cache " << filename << std::endl;
+      return false;
+    }
+    struct stat filestat;
+    if (fstat(fd, &filestat) < 0 || static_cast<size_t>(filestat.st_size) < EventCacheFormat::kFileHeaderSize)
+    {
+      std::cerr << "Event cache " << filename << " too short" << std::endl;
+      ::close(fd);
+      return false;
+    }
+    mSize = filestat.st_size;
+    void *mapped = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+      std::cerr << "Cannot map event cache " << filename << std::endl;
+      return false;
+    }
+    mData = static_cast<const char *>(mapped);
+    madvise(mapped, mSize, MADV_SEQUENTIAL);
+    uint32_t version;
+    std::memcpy(&version, mData + sizeof(EventCacheFormat::kMagic), sizeof(uint32_t));
+    if (std::memcmp(mData, EventCacheFormat::kMagic, sizeof(EventCacheFormat::kMagic)) || version != EventCacheFormat::kVersion)
+    {
+      std::cerr << "File " << filename << " is not an event cache of version " << EventCacheFormat::kVersion << std::endl;
+      close();
+      return false;
+    }
+    mNextOffset = EventCacheFormat::kFileHeaderSize;
+    if (!validate(filename))
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  /// Number of events in the cache as stored by the writer
+  uint32_t getNEvents() const { return mNevents; }
+
+  void close()
+  {
+    if (mData)
+      munmap(const_cast<char *>(mData), mSize);
+    mData = nullptr;
+    mSize = 0;
+    mNextOffset = 0;
+    mNevents = 0;
+  }
+
+  /// Get the next event, false at the end of the file
+  bool next(EventCacheEvent &event)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mData || mNextOffset + sizeof(EventCacheHeader) > mSize)
+      return false;
+    auto header = reinterpret_cast<const EventCacheHeader *>(mData + mNextOffset);
+    size_t recordsize = sizeof(EventCacheHeader) + header->nparticles * sizeof(CachedParticle) + header->npartons * sizeof(CachedParton);
+    if (mNextOffset + recordsize > mSize)
+    {
+      std::cerr << "Truncated event record at offset " << mNextOffset << ", stopping" << std::endl;
+      mNextOffset = mSize;
+      return false;
+    }
+    auto particles = reinterpret_cast<const CachedParticle *>(mData + mNextOffset + sizeof(EventCacheHeader));
+    auto partons = reinterpret_cast<const CachedParton *>(particles + header->nparticles);
+    event = EventCacheEvent(header, particles, partons);
+    mNextOffset += recordsize;
+    return true;
+  }
+
+private:
+  /// Check that the file was closed by the writer and that the records fill the file
+  /// exactly with the stored number of events
+  bool validate(const char *filename)
+  {
+    std::memcpy(&mNevents, mData + EventCacheFormat::kEventCountOffset, sizeof(uint32_t));
+    if (!mNevents)
+    {
+      std::cerr << "Event cache " << filename << " is empty or incomplete (writer failed or was not closed)" << std::endl;
+      return false;
+    }
+    size_t offset = EventCacheFormat::kFileHeaderSize;
+    uint32_t nrecords = 0;
+    while (offset + sizeof(EventCacheHeader) <= mSize)
+    {
+      auto header = reinterpret_cast<const EventCacheHeader *>(mData + offset);
+      size_t recordsize = sizeof(EventCacheHeader) + header->nparticles * sizeof(CachedParticle) + header->npartons * sizeof(CachedParton);
+      if (offset + recordsize > mSize)
+        break;
+      offset += recordsize;
+      nrecords++;
+    }
+    if (offset != mSize || nrecords != mNevents)
+    {
+      std::cerr << "Event cache " << filename << " is corrupted: " << nrecords << " complete records, " << mSize - offset << " trailing bytes, expected " << mNevents << " events" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  const char *mData = nullptr;
+  size_t mSize = 0;
+  size_t mNextOffset = 0;
+  uint32_t mNevents = 0;
+  std::mutex mMutex;
+};
+
+#endif
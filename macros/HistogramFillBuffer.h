@@ -0,0 +1,89 @@
+#ifndef HISTOGRAMFILLBUFFER_H
+#define HISTOGRAMFILLBUFFER_H
+
+#include <vector>
+
+#include <TH1.h>
+#include <TH2.h>
+
+/// Collects fills for one histogram and hands them over in batches via FillN.
+///
+/// The buffer is owned by the same worker as the histogram, so no locking is
+/// needed. Pending fills are passed to the histogram when the buffer is full
+/// and on flush(), which must be called before the histogram is merged or
+/// written. Weights are only stored once the first fill with weight != 1
+/// arrives, unweighted histograms are filled with FillN(..., nullptr).
+class HistogramFillBuffer
+{
+public:
+  HistogramFillBuffer() = default;
+  ~HistogramFillBuffer() = default;
+
+  void setHistogram(TH1 *hist, bool is2D, int capacity = 512)
+  {
+    mHistogram = hist;
+    mIs2D = is2D;
+    mCapacity = capacity;
+    mX.reserve(capacity);
+    if (is2D)
+      mY.reserve(capacity);
+  }
+
+  void fill1D(double x, double weight = 1.)
+  {
+    mX.push_back(x);
+    addWeight(weight);
+    if (static_cast<int>(mX.size()) >= mCapacity)
+      flush();
+  }
+
+  void fill2D(double x, double y, double weight = 1.)
+  {
+    mX.push_back(x);
+    mY.push_back(y);
+    addWeight(weight);
+    if (static_cast<int>(mX.size()) >= mCapacity)
+      flush();
+  }
+
+  void flush()
+  {
+    if (!mX.size())
+      return;
+    const double *weights = mWeighted ? mW.data() : nullptr;
+    // TH1 declares the 2D FillN without a default stride, only TH2 adds it
+    if (mIs2D)
+      mHistogram->FillN(mX.size(), mX.data(), mY.data(), weights, 1);
+    else
+      mHistogram->FillN(mX.size(), mX.data(), weights);
+    mX.clear();
+    mY.clear();
+    mW.clear();
+    mWeighted = false;
+  }
+
+  TH1 *getHistogram() const { return mHistogram; }
+
+private:
+  void addWeight(double weight)
+  {
+    if (!mWeighted && weight != 1.)
+    {
+      // first weighted entry: weights of the entries so far are 1
+      mW.assign(mX.size() - 1, 1.);
+      mWeighted = true;
+    }
+    if (mWeighted)
+      mW.push_back(weight);
+  }
+
+  TH1 *mHistogram = nullptr;
+  bool mIs2D = false;
+  bool mWeighted = false;
+  int mCapacity = 512;
+  std::vector<double> mX;
+  std::vector<double> mY;
+  std::vector<double> mW;
+};
+
+#endif
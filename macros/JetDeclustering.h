@@ -0,0 +1,87 @@
+#ifndef JETDECLUSTERING_H
+#define JETDECLUSTERING_H
+
+#include <utility>
+#include <vector>
+
+#include <fastjet/PseudoJet.hh>
+#include <fastjet/ClusterSequence.hh>
+#include <fastjet/JetDefinition.hh>
+
+struct SoftDropData
+{
+  double Zg;
+  double Rg;
+  int DropCount;
+};
+
+/// Cambridge/Aachen declustering of a jet, done once per jet.
+///
+/// The constituents are reclustered with C/A (R = 1, E-scheme) and the
+/// hardest C/A jet is declustered following the harder branch. Only the
+/// primary splittings are stored, which is all SoftDrop (beta = 0) and the
+/// iterative SoftDrop multiplicity need: Zg, Rg, theta_g and Nsd are all
+/// read off the same splitting list instead of reclustering the jet for
+/// each observable.
+class DeclusteringTree
+{
+public:
+  struct Splitting
+  {
+    double z;
+    double deltaR;
+  };
+
+  DeclusteringTree() = default;
+  ~DeclusteringTree() = default;
+
+  void build(const std::vector<fastjet::PseudoJet> &constituents)
+  {
+    mSplittings.clear();
+    if (!constituents.size())
+      return;
+    fastjet::ClusterSequence recluster(constituents, mDefinition);
+    auto outputJets = fastjet::sorted_by_pt(recluster.inclusive_jets(0));
+    fastjet::PseudoJet harder, softer, splitting = outputJets[0];
+    while (splitting.has_parents(harder, softer))
+    {
+      if (harder.perp() < softer.perp())
+        std::swap(harder, softer);
+      mSplittings.push_back({softer.perp() / (harder.perp() + softer.perp()), harder.delta_R(softer)});
+      splitting = harder;
+    }
+  }
+
+  /// First splitting passing the SoftDrop condition z > zcut (beta = 0).
+  /// Jets without accepted splitting get Zg = 0.
+  SoftDropData softDrop(double zcut) const
+  {
+    for (size_t isplit = 0; isplit < mSplittings.size(); isplit++)
+    {
+      const auto &split = mSplittings[isplit];
+      if (split.z > zcut)
+        return {split.z, split.deltaR, static_cast<int>(isplit)};
+    }
+    return {0., 0., static_cast<int>(mSplittings.size())};
+  }
+
+  /// Number of primary splittings passing z > zcut (iterative SoftDrop)
+  int nsd(double zcut) const
+  {
+    int count = 0;
+    for (const auto &split : mSplittings)
+    {
+      if (split.z > zcut)
+        count++;
+    }
+    return count;
+  }
+
+  const std::vector<Splitting> &getSplittings() const { return mSplittings; }
+
+private:
+  fastjet::JetDefinition mDefinition{fastjet::cambridge_algorithm, 1., fastjet::E_scheme, fastjet::BestFJ30};
+  std::vector<Splitting> mSplittings;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef PARTICLEBUFFER_H
+#define PARTICLEBUFFER_H
+
+#include <cmath>
+#include <vector>
+
+#include <fastjet/PseudoJet.hh>
+
+/// Reusable struct-of-arrays buffer for the final-state particles of an event.
+///
+/// Particles are added with add(), the kinematic acceptance is applied to the
+/// whole buffer at once with select(), and the accepted particles are handed
+/// to fastjet with fillPseudoJets(). The identity of a particle travels as
+/// user_index (index of the particle in the event record). All arrays keep
+/// their capacity between events, so once the buffer has seen the largest
+/// event no further heap allocation happens.
+class ParticleBuffer
+{
+public:
+  ParticleBuffer() = default;
+  ~ParticleBuffer() = default;
+
+  void clear()
+  {
+    mPx.clear();
+    mPy.clear();
+    mPz.clear();
+    mE.clear();
+    mPdg.clear();
+    mIndex.clear();
+  }
+
+  void add(double px, double py, double pz, double e, int pdg, int index)
+  {
+    mPx.push_back(px);
+    mPy.push_back(py);
+    mPz.push_back(pz);
+    mE.push_back(e);
+    mPdg.push_back(pdg);
+    mIndex.push_back(index);
+  }
+
+  /// Keep only particles with |eta| <= etamax and, if phimin and phimax are
+  /// both >= 0, with phi (in [0, 2pi)) inside [phimin, phimax]
+  void select(double etamax, double phimin = -1., double phimax = -1.)
+  {
+    const int nparticles = mPx.size();
+    mPt.resize(nparticles);
+    mEta.resize(nparticles);
+    mPhi.resize(nparticles);
+    mAccepted.resize(nparticles);
+    const bool cutPhi = phimin >= 0. && phimax >= 0.;
+    // branch-free kinematics and acceptance over contiguous arrays
+    for (int ipart = 0; ipart < nparticles; ipart++)
+    {
+      double pt = std::sqrt(mPx[ipart] * mPx[ipart] + mPy[ipart] * mPy[ipart]),
+             phi = std::atan2(mPy[ipart], mPx[ipart]);
+      mPt[ipart] = pt;
+      mEta[ipart] = std::asinh(mPz[ipart] / pt);
+      mPhi[ipart] = phi < 0. ? phi + 2. * M_PI : phi; // same as TVector2::Phi_0_2pi for atan2 output
+    }
+    for (int ipart = 0; ipart < nparticles; ipart++)
+    {
+      bool inPhi = !cutPhi || (mPhi[ipart] >= phimin && mPhi[ipart] <= phimax);
+      mAccepted[ipart] = std::abs(mEta[ipart]) <= etamax && inPhi;
+    }
+    // compact accepted particles to the front, keeping the order of the event
+    int naccepted = 0;
+    for (int ipart = 0; ipart < nparticles; ipart++)
+    {
+      if (!mAccepted[ipart])
+        continue;
+      mPx[naccepted] = mPx[ipart];
+      mPy[naccepted] = mPy[ipart];
+      mPz[naccepted] = mPz[ipart];
+      mE[naccepted] = mE[ipart];
+      mPt[naccepted] = mPt[ipart];
+      mEta[naccepted] = mEta[ipart];
+      mPhi[naccepted] = mPhi[ipart];
+      mPdg[naccepted] = mPdg[ipart];
+      mIndex[naccepted] = mIndex[ipart];
+      naccepted++;
+    }
+    mPx.resize(naccepted);
+    mPy.resize(naccepted);
+    mPz.resize(naccepted);
+    mE.resize(naccepted);
+    mPt.resize(naccepted);
+    mEta.resize(naccepted);
+    mPhi.resize(naccepted);
+    mPdg.resize(naccepted);
+    mIndex.resize(naccepted);
+  }
+
+  /// Replace the content of output with the particles in the buffer
+  void fillPseudoJets(std::vector<fastjet::PseudoJet> &output) const
+  {
+    output.clear();
+    for (int ipart = 0; ipart < size(); ipart++)
+    {
+      output.emplace_back(mPx[ipart], mPy[ipart], mPz[ipart], mE[ipart]);
+      output.back().set_user_index(mIndex[ipart]);
+    }
+  }
+
+  int size() const { return mPx.size(); }
+  size_t capacity() const { return mPx.capacity(); }
+  double getPx(int ipart) const { return mPx[ipart]; }
+  double getPy(int ipart) const { return mPy[ipart]; }
+  double getPz(int ipart) const { return mPz[ipart]; }
+  double getE(int ipart) const { return mE[ipart]; }
+  double getPt(int ipart) const { return mPt[ipart]; }
+  double getEta(int ipart) const { return mEta[ipart]; }
+  double getPhi(int ipart) const { return mPhi[ipart]; }
+  int getPdg(int ipart) const { return mPdg[ipart]; }
+  int getIndex(int ipart) const { return mIndex[ipart]; }
+
+private:
+  std::vector<double> mPx;
+  std::vector<double> mPy;
+  std::vector<double> mPz;
+  std::vector<double> mE;
+  std::vector<double> mPt;
+  std::vector<double> mEta;
+  std::vector<double> mPhi;
+  std::vector<int> mPdg;
+  std::vector<int> mIndex;
+  std::vector<char> mAccepted;
+};
+
+#endif
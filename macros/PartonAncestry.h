@@ -0,0 +1,90 @@
+#ifndef PARTONANCESTRY_H
+#define PARTONANCESTRY_H
+
+#include <vector>
+
+/// Per-event table from particle index to the index of the parton
+/// (quark, gluon or diquark) the particle originates from.
+///
+/// The origin of a particle is the first parton found when following the
+/// chain of first mothers upwards, the particle itself excluded. The table
+/// is filled once per event for all particles; every chain is walked only
+/// until it hits a particle which is already resolved, and the result is
+/// written back along the walked path. In event records where mothers are
+/// stored before their daughters this is a single pass over the event.
+///
+/// The event record is accessed via two callables:
+/// - motherOf(index): index of the first mother, or -1 if there is none
+/// - isParton(index): whether the particle is a quark, gluon or diquark
+class PartonAncestry
+{
+public:
+  enum
+  {
+    kNoOrigin = -1,
+    kUnresolved = -2,
+    kInProgress = -3
+  };
+
+  PartonAncestry() = default;
+  ~PartonAncestry() = default;
+
+  template <typename MotherFunc, typename PartonFunc>
+  void build(int nparticles, MotherFunc &&motherOf, PartonFunc &&isParton)
+  {
+    mOrigin.assign(nparticles, kUnresolved);
+    for (int index = 0; index < nparticles; index++)
+    {
+      if (mOrigin[index] == kUnresolved)
+        resolve(index, motherOf, isParton);
+    }
+  }
+
+  /// Index of the originating parton, kNoOrigin if the chain ends without parton
+  int getOrigin(int index) const
+  {
+    if (index < 0 || index >= static_cast<int>(mOrigin.size()))
+      return kNoOrigin;
+    return mOrigin[index];
+  }
+
+  int size() const { return mOrigin.size(); }
+  size_t capacity() const { return mOrigin.capacity(); }
+
+private:
+  template <typename MotherFunc, typename PartonFunc>
+  void resolve(int index, MotherFunc &motherOf, PartonFunc &isParton)
+  {
+    int nparticles = mOrigin.size(), current = index, result = kNoOrigin;
+    mPath.clear();
+    while (true)
+    {
+      mOrigin[current] = kInProgress;
+      mPath.push_back(current);
+      int mother = motherOf(current);
+      if (mother < 0 || mother >= nparticles)
+        break;
+      if (isParton(mother))
+      {
+        result = mother;
+        break;
+      }
+      int known = mOrigin[mother];
+      if (known == kInProgress)
+        break; // broken record with a mother loop
+      if (known != kUnresolved)
+      {
+        result = known;
+        break;
+      }
+      current = mother;
+    }
+    for (auto particle : mPath)
+      mOrigin[particle] = result;
+  }
+
+  std::vector<int> mOrigin;
+  std::vector<int> mPath;
+};
+
+#endif
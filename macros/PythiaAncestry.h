@@ -0,0 +1,39 @@
+#ifndef PYTHIAANCESTRY_H
+#define PYTHIAANCESTRY_H
+
+#include <cstdlib>
+
+#include "Pythia8/Event.h"
+
+#include "PartonAncestry.h"
+
+/// First entry of Particle::motherList(), computed from mother1/mother2
+/// without building the mother vector:
+/// - beams and incoming partons (status |11|, |12|) and particles without mothers: -1
+/// - one mother or carbon copy (mother2 == 0 or mother2 == mother1): mother1
+/// - mother range or two separate mothers: the lower of the two indices
+inline int getFirstMother(const Pythia8::Particle &particle)
+{
+  int status = std::abs(particle.status()), mother1 = particle.mother1(), mother2 = particle.mother2();
+  if (status == 11 || status == 12)
+    return -1;
+  if (mother1 == 0 && mother2 == 0)
+    return -1;
+  if (mother2 == 0 || mother2 == mother1)
+    return mother1;
+  return mother1 < mother2 ? mother1 : mother2;
+}
+
+inline void buildAncestry(PartonAncestry &ancestry, const Pythia8::Event &event)
+{
+  auto motherOf = [&event](int index)
+  { return getFirstMother(event[index]); };
+  auto isParton = [&event](int index)
+  {
+    const auto &particle = event[index];
+    return particle.isGluon() || particle.isQuark() || particle.isDiquark();
+  };
+  ancestry.build(event.size(), motherOf, isParton);
+}
+
+#endif
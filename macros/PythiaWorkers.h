@@ -0,0 +1,70 @@
+#ifndef PYTHIAWORKERS_H
+#define PYTHIAWORKERS_H
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <TROOT.h>
+#include <ROOT/TSeq.hxx>
+
+#include "Pythia8/Pythia.h"
+
+#include <fastjet/ClusterSequence.hh>
+
+/// Event loop of the Pythia macros over nthreads worker threads (at least one).
+///
+/// Each worker owns one generator, created by configure(threadseed), and one
+/// Worker with its histograms and reusable buffers. Worker must provide
+/// build() and merge(Worker &other). Seeds are spaced by the number of threads,
+/// (seed * nthreads + ithread) % 900000000, so that neighbouring job seeds do
+/// not overlap, for a single thread the seed is the same as in the serial mode.
+/// maxevents is split exactly, the first maxevents % nthreads workers take one
+/// event more. processEvent(pythia, worker) generates and analyses one event.
+/// After the loop the workers are merged into workers[0] in fixed thread order,
+/// so that the result does not depend on the scheduling.
+///
+/// Returns the wall time of the event loop in seconds, without the generator
+/// initialisation and the merge.
+template <typename Worker, typename ConfigureFunc, typename EventFunc>
+double runPythiaWorkers(std::vector<Worker> &workers, int nthreads, int seed, int maxevents, ConfigureFunc configure, EventFunc processEvent)
+{
+  if (nthreads < 1)
+    nthreads = 1;
+  if (nthreads > 1)
+    ROOT::EnableThreadSafety();
+  // print the fastjet banner once before the workers start clustering
+  fastjet::ClusterSequence::print_banner();
+
+  workers.resize(nthreads);
+  std::vector<std::unique_ptr<Pythia8::Pythia>> generators;
+  for (auto ithread : ROOT::TSeqI(0, nthreads))
+  {
+    workers[ithread].build();
+    int threadseed = static_cast<int>((static_cast<long long>(seed) * nthreads + ithread) % 900000000);
+    generators.emplace_back(configure(threadseed));
+  }
+
+  auto eventLoop = [&generators, &workers, &processEvent](int ithread, int nevents)
+  {
+    for (int ievent = 0; ievent < nevents; ievent++)
+      processEvent(*generators[ithread], workers[ithread]);
+  };
+  auto loopstart = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto ithread : ROOT::TSeqI(0, nthreads))
+  {
+    int nevents = maxevents / nthreads + (ithread < maxevents % nthreads ? 1 : 0);
+    threads.emplace_back(eventLoop, ithread, nevents);
+  }
+  for (auto &thread : threads)
+    thread.join();
+  double walltime = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopstart).count();
+
+  for (auto ithread : ROOT::TSeqI(1, nthreads))
+    workers[0].merge(workers[ithread]);
+  return walltime;
+}
+
+#endif
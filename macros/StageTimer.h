@@ -0,0 +1,218 @@
+#ifndef STAGETIMER_H
+#define STAGETIMER_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+
+#include <TH1.h>
+
+/// Accumulated time per stage of the analysis chain and event/jet counters, one
+/// instance per worker. Timing uses std::chrono::steady_clock around each stage
+/// (a few 10 ns per measurement), counters are plain integers, so the
+/// instrumentation can stay enabled in production jobs. Only simAnalysisPythia.C
+/// and makeJetSpectrumAndSoftDrop.C are instrumented, the simPythiaK0* macros
+/// write no timers.
+///
+/// "Buffer regrowths" counts capacity changes of the reusable per-event
+/// buffers registered via trackBuffer(): the particle buffer (0), the jet
+/// finding input (1) and the ancestry table (2). It is not a count of heap
+/// allocations: allocations inside Pythia, HepMC, fastjet or ROOT are not seen.
+///
+/// The wall time is the one of the job, merge() keeps the maximum over the
+/// workers. write() stores the values as histograms in the current directory.
+/// Combined with hadd, times and counters are summed over the jobs, so events
+/// over wall time in hPerformance is the average rate per job.
+class StageTimers
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  enum Stage_t
+  {
+    kEventInput,    ///< generation (Pythia::next) or reading/decoding of the input event
+    kSelection,     ///< select_particles
+    kAncestry,      ///< parton ancestry table
+    kJetFinding,    ///< anti-kt clustering, all R
+    kDeclustering,  ///< C/A declustering, SoftDrop and iterative SoftDrop
+    kPartonOrigin,  ///< getPartonOrigin / jet flavour
+    kHistogramFill, ///< histogram filling
+    kEventCache,    ///< writing the event cache
+    kNStages
+  };
+  enum
+  {
+    kMinR = 2,
+    kMaxR = 6,
+    kMaxBuffers = 8
+  };
+
+  StageTimers() { reset(); }
+  ~StageTimers() = default;
+
+  void reset()
+  {
+    mNanoseconds.fill(0);
+    mCalls.fill(0);
+    mJets.fill(0);
+    mConstituents.fill(0);
+    mBufferCapacity.fill(0);
+    mEvents = 0;
+    mBufferRegrowths = 0;
+    mWallTime = 0.;
+  }
+
+  static Clock::time_point now() { return Clock::now(); }
+
+  void addTime(Stage_t stage, Clock::time_point start)
+  {
+    mNanoseconds[stage] += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    mCalls[stage]++;
+  }
+
+  void countEvent() { mEvents++; }
+
+  void countJet(int R, int nconstituents)
+  {
+    if (R < kMinR || R > kMaxR)
+      return;
+    mJets[R - kMinR]++;
+    mConstituents[R - kMinR] += nconstituents;
+  }
+
+  /// Count a regrowth if the capacity of buffer ibuffer changed since the last call
+  void trackBuffer(int ibuffer, size_t capacity)
+  {
+    if (ibuffer < 0 || ibuffer >= kMaxBuffers)
+      return;
+    if (capacity != mBufferCapacity[ibuffer])
+    {
+      mBufferRegrowths++;
+      mBufferCapacity[ibuffer] = capacity;
+    }
+  }
+
+  /// Wall time of the event loop in seconds, set once by the driver
+  void setWallTime(double walltime) { mWallTime = walltime; }
+
+  void merge(const StageTimers &other)
+  {
+    for (int istage = 0; istage < kNStages; istage++)
+    {
+      mNanoseconds[istage] += other.mNanoseconds[istage];
+      mCalls[istage] += other.mCalls[istage];
+    }
+    for (int ir = 0; ir < kMaxR - kMinR + 1; ir++)
+    {
+      mJets[ir] += other.mJets[ir];
+      mConstituents[ir] += other.mConstituents[ir];
+    }
+    mEvents += other.mEvents;
+    mBufferRegrowths += other.mBufferRegrowths;
+    mWallTime = std::max(mWallTime, other.mWallTime);
+  }
+
+  /// Summary for the job log
+  void print() const
+  {
+    long long total = 0;
+    for (auto nanoseconds : mNanoseconds)
+      total += nanoseconds;
+    std::cout << "Processed " << mEvents << " events in " << mWallTime << " s";
+    if (mWallTime > 0.)
+      std::cout << " (" << mEvents / mWallTime << " events/s)";
+    std::cout << ", " << mBufferRegrowths << " buffer regrowths" << std::endl;
+    auto precision = std::cout.precision();
+    for (int istage = 0; istage < kNStages; istage++)
+    {
+      if (!mCalls[istage])
+        continue;
+      std::cout << "  " << std::left << std::setw(14) << getStageName(istage) << std::right
+                << std::setw(12) << std::fixed << std::setprecision(3) << 1e-9 * mNanoseconds[istage] << " s"
+                << std::setw(8) << std::setprecision(1) << (total ? 100. * mNanoseconds[istage] / total : 0.) << " %"
+                << std::setw(12) << mCalls[istage] << " calls" << std::defaultfloat << std::setprecision(precision) << std::endl;
+    }
+    for (int ir = 0; ir < kMaxR - kMinR + 1; ir++)
+    {
+      std::cout << "  R=0." << ir + kMinR << ": " << mJets[ir] << " jets";
+      if (mJets[ir])
+        std::cout << ", " << double(mConstituents[ir]) / mJets[ir] << " constituents/jet";
+      std::cout << std::endl;
+    }
+  }
+
+  static const char *getStageName(int stage)
+  {
+    const std::array<const char *, kNStages> stagenames = {{"EventInput", "Selection", "Ancestry", "JetFinding", "Declustering", "PartonOrigin", "HistogramFill", "EventCache"}};
+    return stagenames[stage];
+  }
+
+  void write() const
+  {
+    auto hStageTime = new TH1D("hStageTime", "Accumulated time per stage (s, summed over workers)", kNStages, -0.5, kNStages - 0.5),
+         hStageCalls = new TH1D("hStageCalls", "Number of timed calls per stage", kNStages, -0.5, kNStages - 0.5);
+    for (int istage = 0; istage < kNStages; istage++)
+    {
+      hStageTime->GetXaxis()->SetBinLabel(istage + 1, getStageName(istage));
+      hStageTime->SetBinContent(istage + 1, 1e-9 * mNanoseconds[istage]);
+      hStageCalls->GetXaxis()->SetBinLabel(istage + 1, getStageName(istage));
+      hStageCalls->SetBinContent(istage + 1, mCalls[istage]);
+    }
+    auto hJetsPerR = new TH1D("hJetsPerR", "Number of jets per R", kMaxR - kMinR + 1, kMinR - 0.5, kMaxR + 0.5),
+         hConstituentsPerR = new TH1D("hConstituentsPerR", "Number of jet constituents per R", kMaxR - kMinR + 1, kMinR - 0.5, kMaxR + 0.5);
+    for (int ir = 0; ir < kMaxR - kMinR + 1; ir++)
+    {
+      hJetsPerR->SetBinContent(ir + 1, mJets[ir]);
+      hConstituentsPerR->SetBinContent(ir + 1, mConstituents[ir]);
+    }
+    auto hPerformance = new TH1D("hPerformance", "Event loop performance", 3, -0.5, 2.5);
+    hPerformance->GetXaxis()->SetBinLabel(1, "Events");
+    hPerformance->GetXaxis()->SetBinLabel(2, "WallTime");
+    hPerformance->GetXaxis()->SetBinLabel(3, "BufferRegrowths");
+    hPerformance->SetBinContent(1, mEvents);
+    hPerformance->SetBinContent(2, mWallTime);
+    hPerformance->SetBinContent(3, mBufferRegrowths);
+    for (auto hist : {hStageTime, hStageCalls, hJetsPerR, hConstituentsPerR, hPerformance})
+    {
+      hist->Write();
+      delete hist;
+    }
+  }
+
+private:
+  std::array<long long, kNStages> mNanoseconds;
+  std::array<long long, kNStages> mCalls;
+  std::array<long long, kMaxR - kMinR + 1> mJets;
+  std::array<long long, kMaxR - kMinR + 1> mConstituents;
+  std::array<size_t, kMaxBuffers> mBufferCapacity;
+  long long mEvents;
+  long long mBufferRegrowths;
+  double mWallTime;
+};
+
+/// Adds the time between construction and destruction to a stage, or until
+/// stop() for stages whose results must outlive the measurement
+class ScopedStageTimer
+{
+public:
+  ScopedStageTimer(StageTimers &timers, StageTimers::Stage_t stage) : mTimers(timers), mStage(stage), mStart(StageTimers::now()) {}
+  ~ScopedStageTimer() { stop(); }
+
+  void stop()
+  {
+    if (mStopped)
+      return;
+    mTimers.addTime(mStage, mStart);
+    mStopped = true;
+  }
+
+private:
+  StageTimers &mTimers;
+  StageTimers::Stage_t mStage;
+  StageTimers::Clock::time_point mStart;
+  bool mStopped = false;
+};
+
+#endif
@@ -16,7 +16,7 @@ for dr in ${dirs[@]}; do
         eval $cmd
     done
 
-    globfiles=("AnalysisResults.root" "herwig.in" "merge.log")
+    globfiles=("AnalysisResults.root" "herwig.in" "merge_AnalysisResults.log")
     for gf in ${globfiles[@]}; do
         testfile=$INPUTDIR/$gf
         res=$(ls -l 2>&1 | grep $gf | grep -v Permission)
@@ -1,13 +1,16 @@
 #! /bin/bash
+# Scale and merge the pt-hard bins bin0 ... bin20 in the current directory
+# ROOTFILE may point into a subdirectory (e.g. K0StablePi0Stable/AnalysisResults.root),
+# the merged file is written next to it with suffix _merged.
+ROOTFILE=${1:-AnalysisResults.root}
+NTHREADS=${2:-0}
 
 SCRIPT=`readlink -f $0`
 SOURCE=`dirname $SCRIPT`
 
-base=`pwd`
-script=$SOURCE/makeScaled.C
-for i in `seq 0 20`; do
-	bindir=$(printf "bin%d" $i)
-	cd $bindir
-	root -l -b -q $script
-	cd $base
-done
+script=$SOURCE/../pthard/mergePtHardBins.C
+OUTPUTFILE=${ROOTFILE%.root}_merged.root
+outputdir=$(dirname $OUTPUTFILE)
+if [ ! -d $outputdir ]; then mkdir -p $outputdir; fi
+cmd=$(printf "root -l -b -q \'%s(\"%s\", \"%s\", %d, 21)\'" $script $ROOTFILE $OUTPUTFILE $NTHREADS)
+eval $cmd
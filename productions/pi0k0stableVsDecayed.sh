@@ -9,6 +9,7 @@ OUTPUTBASE=/lustre/or-scratch/cades-birthright/mfasel_alice/fastsim/PYTHIA/K0Pi0
 
 MACRO=
 SIMDIR=
+ROOTFILE=AnalysisResults.root
 case $MODE in
 	1) MACRO=simPythiaK0Pi0Decayed.C
 	   SIMDIR=K0DecayedPi0Decayed
@@ -22,6 +23,11 @@ case $MODE in
 	4) MACRO=simPythiaK0Pi0Stable.C
 	   SIMDIR=K0StablePi0Stable
 	   ;;
+	5) # all four variants from the same events, one output directory per variant
+	   MACRO=simPythiaK0Pi0Variants.C
+	   SIMDIR=K0Pi0Correlated
+	   ROOTFILE=K0DecayedPi0Decayed/AnalysisResults.root,K0DecayedPi0Stable/AnalysisResults.root,K0StablePi0Decayed/AnalysisResults.root,K0StablePi0Stable/AnalysisResults.root
+	   ;;
 	*) echo "Mode unsupported"
 	   exit 1
 	   ;;
@@ -31,7 +37,6 @@ OUTPUTDIR=$OUTPUTBASE/$SIMDIR
 NJOB=100
 NEVENT=100000
 EBEAM=6500
-ROOTFILE=AnalysisResults.root
 PARTITION=high_mem_cd
 TIMELIMIT=04:00:00
 
@@ -3,6 +3,7 @@
 INPUTLIST=$1
 OUTPUTDIR=$2
 MACRO=$3
+NWORKERS=${4:-0}
 
 echo "Running analysis on existing sample ..."
 
@@ -28,7 +29,12 @@ ROOTFILE=
 FILEBASE=
 while read filename; do
     echo "Processing file $filename"
-    cmd=$(printf "root -l -b -q \'%s(\"%s\")\' &> analysis.log" $MACRO $filename)
+    if [ $NWORKERS -gt 0 ]; then
+        # pipelined mode: one HepMC decoder thread and NWORKERS analysis threads
+        cmd=$(printf "root -l -b -q \'%s(\"%s\", -1, \"\", %d)\' &> analysis.log" $MACRO $filename $NWORKERS)
+    else
+        cmd=$(printf "root -l -b -q \'%s(\"%s\")\' &> analysis.log" $MACRO $filename)
+    fi
     eval $cmd
     if [ "x$ROOTFILE" == "x" ]; then 
         ROOTFILE=$(ls -1 | grep root)
@@ -0,0 +1,66 @@
+#! /bin/bash
+# Throughput benchmark of the analysis chain on a fixed-seed event sample
+#
+# For each selected pt-hard bin the events are generated once with simAnalysisPythia.C
+# and stored in an event cache (WORKDIR/binN/events.evc). The cache is then replayed
+# with makeJetSpectrumAndSoftDrop.C, so repeated runs (e.g. before and after a code
+# change) analyse identical events. An existing cache is reused, remove it to regenerate.
+# The per-stage timing of generation and replay is printed from the timers stored in
+# the output files.
+#
+# Usage: run_benchmark.sh WORKDIR [PTHARDBINS] [NEVENTS] [SEED] [NWORKERS]
+#   PTHARDBINS: comma-separated list of pt-hard bins (default 1,5,10,15)
+WORKDIR=$1
+PTHARDBINS=${2:-1,5,10,15}
+NEVENTS=${3:-2000}
+SEED=${4:-12345}
+NWORKERS=${5:-0}
+ENERGYCMS=13000
+
+if [ "x$WORKDIR" == "x" ]; then
+    echo "Usage: $0 WORKDIR [PTHARDBINS] [NEVENTS] [SEED] [NWORKERS]"
+    exit 1
+fi
+
+SCRIPTNAME=`readlink -f $0`
+SOURCEDIR=`dirname $SCRIPTNAME`
+GENMACRO=$SOURCEDIR/macros/simAnalysisPythia.C
+ANAMACRO=$SOURCEDIR/macros/makeJetSpectrumAndSoftDrop.C
+REPORTMACRO=$SOURCEDIR/postprocessing/reportStageTimers.C
+
+PACKAGES=(pythia ROOT fastjet HepMC)
+ALIENV=`which alienv`
+if [ "x$ALIENV" != "x" ]; then
+    for pack in ${PACKAGES[@]}; do
+        eval `$ALIENV --no-refresh load $pack/latest`
+    done
+    eval `$ALIENV list`
+fi
+
+echo "Using random seed                 $SEED"
+echo "Pt-hard bins                      $PTHARDBINS"
+echo "Events per pt-hard bin            $NEVENTS"
+echo "Number of analysis workers        $NWORKERS"
+
+for PTHARDBIN in ${PTHARDBINS//,/ }; do
+    BINDIR=$WORKDIR/bin$PTHARDBIN
+    if [ ! -d $BINDIR ]; then mkdir -p $BINDIR; fi
+    cd $BINDIR
+    if [ ! -f events.evc ]; then
+        echo "Generating $NEVENTS events for pt-hard bin $PTHARDBIN ..."
+        # single thread: the sample only depends on the seed
+        cmd=$(printf "root -l -b -q \'%s(%d, %d, %d, %d, 1, \"events.evc\")\' &> generation.log" $GENMACRO $PTHARDBIN $SEED $ENERGYCMS $NEVENTS)
+        eval $cmd
+        mv AnalysisResults.root generation.root
+    fi
+    echo "Replaying event cache for pt-hard bin $PTHARDBIN ..."
+    cmd=$(printf "root -l -b -q \'%s(\"events.evc\", -1, \"\", %d)\' &> replay.log" $ANAMACRO $NWORKERS)
+    eval $cmd
+    mv AnalysisResults.root replay.root
+
+    echo "=== Pt-hard bin $PTHARDBIN: generation ==="
+    root -l -b -q "$REPORTMACRO(\"generation.root\")"
+    echo "=== Pt-hard bin $PTHARDBIN: replay ==="
+    root -l -b -q "$REPORTMACRO(\"replay.root\")"
+    cd - > /dev/null
+done
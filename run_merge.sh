@@ -20,6 +20,12 @@ for d in ${dirs[@]}; do
     fi
 done
 
+# ROOT files of multi-variant productions are in subdirectories (e.g. K0StablePi0Stable/AnalysisResults.root)
+outputdir=$(dirname $ROOTFILE)
+if [ ! -d $outputdir ]; then
+    mkdir -p $outputdir
+fi
+
 cmd=$(printf "hadd -f %s" $ROOTFILE)
 for f in ${fls[@]}; do
     cmd=$(printf "%s %s" "$cmd" $f)
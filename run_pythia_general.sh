@@ -5,6 +5,8 @@ SEED=$3
 ENERGYCMS=$4
 PTHARDBIN=$5
 MACRO=$6
+NCORES=${7:-1}
+EVENTCACHE=${8:-}
 
 CLUSTER_HOME=
 if [ $CLUSTER == "CADES" ]; then
@@ -30,6 +32,13 @@ echo "Using random seed                 $SEED"
 echo "CMS energy                        $ENERGYCMS"
 echo "Pt-hard bin                       $PTHARDBIN"
 echo "Simulating number of events       $NEVENTS"
+echo "Number of worker threads          $NCORES"
 
-cmd=$(printf "root -l -b -q \'%s(%d, %d, %d, %d)\' &> analysis.log" $MACRO $PTHARDBIN $SEED $ENERGYCMS $NEVENTS)
+if [ "x$EVENTCACHE" != "x" ]; then
+    # only macros supporting the binary event cache take the additional argument
+    echo "Writing event cache               $EVENTCACHE"
+    cmd=$(printf "root -l -b -q \'%s(%d, %d, %d, %d, %d, \"%s\")\' &> analysis.log" $MACRO $PTHARDBIN $SEED $ENERGYCMS $NEVENTS $NCORES $EVENTCACHE)
+else
+    cmd=$(printf "root -l -b -q \'%s(%d, %d, %d, %d, %d)\' &> analysis.log" $MACRO $PTHARDBIN $SEED $ENERGYCMS $NEVENTS $NCORES)
+fi
 eval $cmd
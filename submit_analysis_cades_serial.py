@@ -36,11 +36,12 @@ def find_hepmcfiles(inputdir: str) -> list:
     result = []
     for root, dirs, files in os.walk(inputdir):
         for fl in files:
-            if "hepmc" in fl:
+            # HepMC files or binary event caches (.evc) written by the analysis macros
+            if "hepmc" in fl or fl.endswith(".evc"):
                 result.append(os.path.join(root, fl))
     return sorted(result)
 
-def create_jobscript(inputbase: str, outputdir: str, filesperjob: int, macro: str, maxtime: str, queue: str = ""):
+def create_jobscript(inputbase: str, outputdir: str, filesperjob: int, macro: str, maxtime: str, queue: str = "", nworkers: int = 0):
     if not os.path.exists(outputdir):
         os.makedirs(outputdir, 0o755)
 
@@ -79,11 +80,13 @@ def create_jobscript(inputbase: str, outputdir: str, filesperjob: int, macro: st
     batchhandler.configure_from_setup(cluster_setup)
     if len(queue):
         batchhandler.partition = queue
+    # decoder thread + analysis workers
+    batchhandler.numcores = nworkers + 1 if nworkers > 0 else 1
     batchhandler.arraysize = nchunk
     batchhandler.workdir = outputdir
     batchhandler.init_jobscript(jobscriptname)
     batchhandler.message("Starting analysis in current workdir ...")
-    process_runner = runhandler(sourcedir, os.path.join(sourcedir, "run_analysis_general.sh"), ["$WORKDIR/inputfiles.txt", "$WORKDIR", macroname])
+    process_runner = runhandler(sourcedir, os.path.join(sourcedir, "run_analysis_general.sh"), ["$WORKDIR/inputfiles.txt", "$WORKDIR", macroname, nworkers])
     process_runner.initialize(cluster_setup)
     process_runner.set_logfile("run_analysis.log")
     batchhandler.launch(process_runner)
@@ -92,8 +95,8 @@ def create_jobscript(inputbase: str, outputdir: str, filesperjob: int, macro: st
     batchhandler.finish_jobscript()
     return jobscriptname
 
-def submit_analysis_cades(inputdir: str, outputdir: str, numfiles: int, macro: str, timelimit, rootfile = None, queue: str = ""):
-    jobid = launch_job(create_jobscript(inputdir, outputdir, numfiles, macro, timelimit, queue))
+def submit_analysis_cades(inputdir: str, outputdir: str, numfiles: int, macro: str, timelimit, rootfile = None, queue: str = "", nworkers: int = 0):
+    jobid = launch_job(create_jobscript(inputdir, outputdir, numfiles, macro, timelimit, queue, nworkers))
     if rootfile:
         submit_merge(outputdir, rootfile, jobid, queue)
 
@@ -106,6 +109,7 @@ if __name__ == "__main__":
     parser.add_argument("-r", "--rootfile", metavar="ROOTFILE", type=str, default="", help="Name of the resulting roofile (for merging)")
     parser.add_argument("-t", "--timelimit", metavar="TIMELIMIT", type=str, default="10:00:00", help="Max. time per slot")
     parser.add_argument("-q", "--queue", metavar="QUEUE", default="gpu", help="Queue/Partition (default: gpu)")
+    parser.add_argument("-w", "--workers", metavar="WORKERS", type=int, default=0, help="Number of analysis worker threads (0: serial analysis)")
     parser.add_argument("-d" ,"--debug", metavar="DEBUG", action="store_true", help="Enable debug printouts")
     args = parser.parse_args()
     loglevel = logging.INFO
@@ -115,4 +119,4 @@ if __name__ == "__main__":
     rootfile = None
     if len(args.rootfile):
         rootfile = args.rootfile
-    submit_analysis_cades(args.inputdir, args.outputdir, args.nfiles, args.macro, args.timelimit, rootfile, args.queue)
\ No newline at end of file
+    submit_analysis_cades(args.inputdir, args.outputdir, args.nfiles, args.macro, args.timelimit, rootfile, args.queue, args.workers)
\ No newline at end of file
@@ -15,6 +15,7 @@ if __name__ == "__main__":
     parser.add_argument("-r", "--rootfile", metavar="ROOTFILE", type=str, default="", help="Name of the rootfile")
     parser.add_argument("-t", "--timelimit", metavar="TIMELIMIT", type=str, default="10:00:00", help="Time limit")
     parser.add_argument("-q", "--queue", metavar="QUEUE", default="gpu", help="Queue/Partition (default: gpu)")
+    parser.add_argument("-w", "--workers", metavar="WORKERS", type=int, default=0, help="Number of analysis worker threads (0: serial analysis)")
     parser.add_argument("-d", "--debug", action="store_true", help="Enable debug messages")
     args = parser.parse_args()
 
@@ -34,5 +35,5 @@ if __name__ == "__main__":
             continue
         if cnt.isdigit() or "bin" in cnt:
             print("Submit analysis for {WORKDIR} to outputdir {OUTPUTDIR}".format(WORKDIR=tstdir, OUTPUTDIR=outwork))
-            submit_analysis_cades(tstdir, outwork, args.numfiles, args.macro, args.timelimit, rootfile, args.queue)
+            submit_analysis_cades(tstdir, outwork, args.numfiles, args.macro, args.timelimit, rootfile, args.queue, args.workers)
     pass
\ No newline at end of file
@@ -13,8 +13,11 @@ repo = os.path.dirname(os.path.abspath(sys.argv[0]))
 def create_jobscript(workdir: str, rootfile: str , maxtime: str, dependency=None, queue: str = ""):
     cluster_setup = cluster_factory()
     workerscript = os.path.join(repo, "run_merge.sh")
-    jobscriptname = os.path.join(workdir, "jobscript_merge.sh")
-    logfile = os.path.join(workdir, "merge.log")
+    # one jobscript and log per ROOT file, several merge jobs can run in the same workdir
+    # (e.g. K0StablePi0Stable/AnalysisResults.root -> merge_K0StablePi0Stable_AnalysisResults.log)
+    mergetag = os.path.splitext(rootfile)[0].replace("/", "_")
+    jobscriptname = os.path.join(workdir, "jobscript_merge_{}.sh".format(mergetag))
+    logfile = os.path.join(workdir, "merge_{}.log".format(mergetag))
     batchhandler = slurm("merge_sim", logfile, maxtime, "2G")
     batchhandler.configure_from_setup(cluster_setup)
     batchhandler.workdir = workdir
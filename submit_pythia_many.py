@@ -13,9 +13,11 @@ if __name__ == "__main__":
     parser.add_argument("-n", "--nevents", type=int, default=10000, help="Number of events")
     parser.add_argument("-e", "--ebeam", type=int, default=6500, help="Beam energy")        
     parser.add_argument("-m", "--macro", type=str, default = "makeJetSpectrumAndSoftDrop.C", help="Optional run macro")
-    parser.add_argument("-r", "--rootfile", type=str, default="", help="ROOT file (for merging, optional)")
+    parser.add_argument("-r", "--rootfile", type=str, default="", help="ROOT file(s), comma-separated (for merging, optional)")
     parser.add_argument("-t", "--timelimit", metavar="TIMELIMIT", type=str, default="14:00:00", help="Time limit")
     parser.add_argument("-q", "--queue", metavar="QUEUE", default="gpu", help="Queue/Partition (default: gpu)")
+    parser.add_argument("-c", "--cores", metavar="CORES", type=int, default=1, help="Number of cores (worker threads) per job")
+    parser.add_argument("--memory", metavar="MEMORY", type=str, default="4G", help="Memory limit per job (default: 4G, increase when running several cores)")
     parser.add_argument("-d", "--debug", action="store_true", help="Enable debug messages")
     parser.add_argument("--minpthard", metavar="MINPTHARD", type=int, default=0, help="Min. pt-hard bin")
     parser.add_argument("--maxpthard", metavar="MAXPTHARD", type=int, default=20, help="Max. pt-hard bin")
@@ -34,4 +36,4 @@ if __name__ == "__main__":
     for ipth in range(args.minpthard, args.maxpthard+1):
         logging.info("submitting {}".format(ipth))
         outbindir =os.path.join(args.outputdir, "bin{}".format(ipth))
-        submit_simulation_analysis_pythia(outbindir, args.jobs, args.nevents, args.ebeam, ipth, args.macro, args.timelimit, rootfile, args.queue)
\ No newline at end of file
+        submit_simulation_analysis_pythia(outbindir, args.jobs, args.nevents, args.ebeam, ipth, args.macro, args.timelimit, rootfile, args.queue, args.cores, memory=args.memory)
\ No newline at end of file
@@ -12,7 +12,7 @@ from submit_merge import submit_merge
 
 sourcedir = os.path.dirname(os.path.abspath(sys.argv[0]))
 
-def createJobscript(outputdir: str, maxtime: str, nslots: int, nevents: int, energy_cms: float, pthardbin: int, macro: str, queue: str = "gpu"):
+def createJobscript(outputdir: str, maxtime: str, nslots: int, nevents: int, energy_cms: float, pthardbin: int, macro: str, queue: str = "gpu", ncores: int = 1, eventcache: str = "", memory: str = "4G"):
     cluster_setup = cluster_factory()
 
     jobscriptname = os.path.join(outputdir, "jobscript.sh")
@@ -27,16 +27,20 @@ def createJobscript(outputdir: str, maxtime: str, nslots: int, nevents: int, ene
         logging.info("Loading macro from defuault macro location %s", macrolocation)
         macroname = os.path.join(macrolocation, macro)
 
-    batchhandler = slurm("pythia", logfile, maxtime, "4G")
+    batchhandler = slurm("pythia", logfile, maxtime, memory)
     if len(queue):
         batchhandler.partition = queue
+    batchhandler.numcores = ncores
     batchhandler.arraysize = nslots
     batchhandler.workdir = outputdir
     batchhandler.configure_from_setup(cluster_setup)
     batchhandler.init_jobscript(jobscriptname)
     batchhandler.message("Running simulation ...")
     batchhandler.write_instruction("SEED=$SLURM_JOBID")
-    process_runner = runhandler(sourcedir, os.path.join(sourcedir, "run_pythia_general.sh"), [cluster_setup.name(), nevents, "$SEED", energy_cms, pthardbin, macroname])
+    runargs = [cluster_setup.name(), nevents, "$SEED", energy_cms, pthardbin, macroname, ncores]
+    if len(eventcache):
+        runargs.append(eventcache)
+    process_runner = runhandler(sourcedir, os.path.join(sourcedir, "run_pythia_general.sh"), runargs)
     process_runner.initialize(cluster_setup)
     process_runner.set_logfile("run_pythia.log")
     batchhandler.launch(process_runner)
@@ -46,13 +50,15 @@ def createJobscript(outputdir: str, maxtime: str, nslots: int, nevents: int, ene
     return jobscriptname
 
 
-def submit_simulation_analysis_pythia(outputdir: str, jobs: int, events: int, energybeam: float, pthardbin: int, macro: str, timelimit: str, rootfile=None, queue: str = ""):
+def submit_simulation_analysis_pythia(outputdir: str, jobs: int, events: int, energybeam: float, pthardbin: int, macro: str, timelimit: str, rootfile=None, queue: str = "", ncores: int = 1, eventcache: str = "", memory: str = "4G"):
     logging.basicConfig(format='[%(levelname)s]: %(message)s', level=logging.INFO)
     if not os.path.exists(outputdir):
         os.makedirs(outputdir, 0o755)
-    jobid = launch_job(createJobscript(outputdir, timelimit, jobs, events, 2*energybeam, pthardbin, macro, queue))
+    jobid = launch_job(createJobscript(outputdir, timelimit, jobs, events, 2*energybeam, pthardbin, macro, queue, ncores, eventcache, memory))
     if rootfile:
-        submit_merge(outputdir, rootfile, jobid, queue)
+        # comma-separated list for macros writing more than one output file
+        for mergefile in rootfile.split(","):
+            submit_merge(outputdir, mergefile, jobid, queue)
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser("submit_herwig.py", "Submitter for POWHEG dijet process")
@@ -62,9 +68,12 @@ if __name__ == "__main__":
     parser.add_argument("-p", "--pthardbin", metavar="PTHARDBIN", type=int, required=True, help="Beam energy")
     parser.add_argument("-m", "--macro", metavar="MACRO", type=str, default="makeJetSpectrumAndSoftDrop.C", help="run macro")
     parser.add_argument("-o", "--outputdir", metavar="OUTPUTDIR", type=str, required=True, help="Output directory")
-    parser.add_argument("-r", "--rootfile", metavar="ROOTFILE", type=str, default="", help="ROOT file name (for merging, optional)")
+    parser.add_argument("-r", "--rootfile", metavar="ROOTFILE", type=str, default="", help="ROOT file name(s), comma-separated (for merging, optional)")
     parser.add_argument("-t", "--time", metavar="TIME", default="10:00:00", help="Max. time")
     parser.add_argument("-q", "--queue", metavar="QUEUE", default="gpu", help="Queue/Partition (default: gpu)")
+    parser.add_argument("-c", "--cores", metavar="CORES", type=int, default=1, help="Number of cores (worker threads) per job")
+    parser.add_argument("--memory", metavar="MEMORY", type=str, default="4G", help="Memory limit per job (default: 4G, increase when running several cores)")
+    parser.add_argument("--eventcache", metavar="EVENTCACHE", type=str, default="", help="Name of the binary event cache written by each job (optional, simAnalysisPythia.C only)")
     parser.add_argument("-d" ,"--debug", action="store_true", help="Enable debug printouts")
     args = parser.parse_args()
     loglevel = logging.INFO
@@ -74,4 +83,4 @@ if __name__ == "__main__":
     rootfile = None
     if len(args.rootfile):
         rootfile = args.rootfile
-    submit_simulation_analysis_pythia(args.outputdir, args.jobs, args.nevents, args.ebeam, args.pthardbin, args.macro, args.time, rootfile, args.queue)
\ No newline at end of file
+    submit_simulation_analysis_pythia(args.outputdir, args.jobs, args.nevents, args.ebeam, args.pthardbin, args.macro, args.time, rootfile, args.queue, args.cores, args.eventcache, args.memory)
\ No newline at end of file